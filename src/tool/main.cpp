@@ -5,6 +5,28 @@
 #include <filesystem>
 #include <stdexcept>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#  include <elf.h>
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <sys/inotify.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 #include <stdcorelib/system.h>
 #include <stdcorelib/console.h>
@@ -27,6 +49,7 @@ struct GlobalContext {
     bool verbose = false;
     fs::path cmakePath = _TSTR("cmake");
     fs::path ninjaPath = _TSTR("ninja");
+    std::string cmakeVersion;
 
     fs::path dir;
     fs::path output;
@@ -34,6 +57,15 @@ struct GlobalContext {
     fs::path script;
 
     std::vector<std::string> extraArgs;
+
+    bool watch = false;
+    int debounce = 500;
+
+    int jobs = 1;
+
+    bool genex = false;
+
+    bool resolveLinks = false;
 };
 
 namespace tool {
@@ -97,7 +129,406 @@ namespace tool {
             return true;
         }
 
+        // Splits a statement into unescaped tokens, `colon` receives the number of tokens
+        // before the first unescaped ':'.
+        static std::vector<std::string> split_statement(std::string_view line, size_t &colon) {
+            std::vector<std::string> tokens;
+            std::string token;
+            bool has_token = false;
+            colon = std::string_view::npos;
+
+            auto flush = [&]() {
+                if (has_token) {
+                    tokens.push_back(std::move(token));
+                    token.clear();
+                    has_token = false;
+                }
+            };
+            for (size_t i = 0; i < line.size(); ++i) {
+                char ch = line[i];
+                if (ch == '$' && i + 1 < line.size()) {
+                    char next = line[++i];
+                    if (next != ' ' && next != ':' && next != '$') {
+                        token += '$';
+                    }
+                    token += next;
+                    has_token = true;
+                    continue;
+                }
+                if (::isspace(ch)) {
+                    flush();
+                    continue;
+                }
+                if (ch == ':' && colon == std::string_view::npos) {
+                    flush();
+                    colon = tokens.size();
+                    continue;
+                }
+                token += ch;
+                has_token = true;
+            }
+            flush();
+            return tokens;
+        }
+
+        // Collects the explicit and implicit inputs of the RERUN_CMAKE statement, which are
+        // all the files read by the CMake configuration.
+        // e.g.
+        //      build build.ninja: RERUN_CMAKE | ../CMakeLists.txt /usr/lib/cmake/...
+        static std::vector<fs::path> read_cmake_inputs(const fs::path &ninjaFilePath,
+                                                       const fs::path &build_dir) {
+            std::ifstream ninjaFile(ninjaFilePath);
+            if (!ninjaFile.is_open()) {
+                throw std::runtime_error(stdc::formatN("failed to open file: %1", ninjaFilePath));
+            }
+
+            std::vector<fs::path> inputs;
+            std::string line;
+            std::string statement;
+            while (std::getline(ninjaFile, line)) {
+                std::string_view line_view = line;
+                if (!line_view.empty() && line_view.back() == '\r') {
+                    line_view.remove_suffix(1);
+                }
+
+                // join lines continued with a trailing "$"
+                if (!statement.empty()) {
+                    auto idx = line_view.find_first_not_of(' ');
+                    line_view.remove_prefix(std::min(idx, line_view.size()));
+                }
+                auto last = line_view.find_last_not_of('$');
+                size_t dollars = line_view.size() - (last == std::string_view::npos ? 0 : last + 1);
+                if (dollars % 2 == 1) {
+                    statement.append(line_view.substr(0, line_view.size() - 1));
+                    continue;
+                }
+                statement.append(line_view);
+
+                if (stdc::starts_with(statement, "build") &&
+                    statement.find("RERUN_CMAKE") != std::string::npos) {
+                    size_t colon;
+                    auto tokens = split_statement(statement, colon);
+                    if (colon < tokens.size() && tokens[colon] == "RERUN_CMAKE") {
+                        for (size_t i = colon + 1; i < tokens.size(); ++i) {
+                            const auto &token = tokens[i];
+                            if (token == "|") {
+                                continue;
+                            }
+                            if (token == "||" || token == "|@") {
+                                break;
+                            }
+                            fs::path path = stdc::path::from_utf8(token);
+                            if (path.is_relative()) {
+                                path = build_dir / path;
+                            }
+                            inputs.push_back(path.lexically_normal());
+                        }
+                    }
+                }
+                statement.clear();
+            }
+            return inputs;
+        }
+
+    }
+
+    namespace json {
+
+        static std::string escape(std::string_view s) {
+            std::string result;
+            result.reserve(s.size());
+            for (char ch : s) {
+                switch (ch) {
+                    case '"':
+                        result += "\\\"";
+                        break;
+                    case '\\':
+                        result += "\\\\";
+                        break;
+                    case '\n':
+                        result += "\\n";
+                        break;
+                    case '\r':
+                        result += "\\r";
+                        break;
+                    case '\t':
+                        result += "\\t";
+                        break;
+                    default:
+                        if ((unsigned char) ch < 0x20) {
+                            char buf[8];
+                            std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char) ch);
+                            result += buf;
+                        } else {
+                            result += ch;
+                        }
+                        break;
+                }
+            }
+            return result;
+        }
+
+    }
+
+#ifdef __linux__
+    namespace elf {
+
+        struct FileInfo {
+            // "shared", "static", "script" or "unknown"
+            std::string type;
+            std::string soname;
+            std::vector<std::string> needed;
+            // file arguments of a linker script, e.g. "/lib/libm.so.6" or "-lmvec"
+            std::vector<std::string> inputs;
+        };
+
+        template <class Ehdr, class Phdr, class Shdr, class Dyn>
+        static void read_dynamic(const unsigned char *data, size_t size, FileInfo &info) {
+            if (size < sizeof(Ehdr)) {
+                return;
+            }
+            auto ehdr = reinterpret_cast<const Ehdr *>(data);
+            if (ehdr->e_type != ET_DYN) {
+                return;
+            }
+            info.type = "shared";
+
+            const Dyn *entries = nullptr;
+            size_t count = 0;
+            const char *strings = nullptr;
+            size_t stringsSize = 0;
+
+            // the loader only sees the segments, the section headers may be stripped
+            if (ehdr->e_phentsize == sizeof(Phdr) && ehdr->e_phoff <= size &&
+                (size - ehdr->e_phoff) / sizeof(Phdr) >= ehdr->e_phnum) {
+                auto segments = reinterpret_cast<const Phdr *>(data + ehdr->e_phoff);
+                auto file_offset = [&](uint64_t addr, uint64_t &offset) {
+                    for (size_t i = 0; i < ehdr->e_phnum; ++i) {
+                        const auto &load = segments[i];
+                        if (load.p_type == PT_LOAD && addr >= load.p_vaddr &&
+                            addr - load.p_vaddr < load.p_filesz) {
+                            offset = addr - load.p_vaddr + load.p_offset;
+                            return offset < size;
+                        }
+                    }
+                    return false;
+                };
+                for (size_t i = 0; i < ehdr->e_phnum; ++i) {
+                    const auto &dynamic = segments[i];
+                    if (dynamic.p_type != PT_DYNAMIC || dynamic.p_offset > size ||
+                        size - dynamic.p_offset < dynamic.p_filesz) {
+                        continue;
+                    }
+                    entries = reinterpret_cast<const Dyn *>(data + dynamic.p_offset);
+                    count = dynamic.p_filesz / sizeof(Dyn);
+
+                    uint64_t strtab = 0, strsz = 0, offset = 0;
+                    for (size_t j = 0; j < count && entries[j].d_tag != DT_NULL; ++j) {
+                        if (entries[j].d_tag == DT_STRTAB) {
+                            strtab = entries[j].d_un.d_ptr;
+                        } else if (entries[j].d_tag == DT_STRSZ) {
+                            strsz = entries[j].d_un.d_val;
+                        }
+                    }
+                    if (strtab && file_offset(strtab, offset)) {
+                        strings = reinterpret_cast<const char *>(data + offset);
+                        stringsSize = std::min<uint64_t>(strsz, size - offset);
+                    }
+                    break;
+                }
+            }
+
+            if (!strings && ehdr->e_shentsize == sizeof(Shdr) && ehdr->e_shoff <= size &&
+                (size - ehdr->e_shoff) / sizeof(Shdr) >= ehdr->e_shnum) {
+                auto sections = reinterpret_cast<const Shdr *>(data + ehdr->e_shoff);
+                for (size_t i = 0; i < ehdr->e_shnum; ++i) {
+                    const auto &dynamic = sections[i];
+                    if (dynamic.sh_type != SHT_DYNAMIC || dynamic.sh_link >= ehdr->e_shnum) {
+                        continue;
+                    }
+                    const auto &strtab = sections[dynamic.sh_link];
+                    if (dynamic.sh_offset > size || size - dynamic.sh_offset < dynamic.sh_size ||
+                        strtab.sh_offset > size || size - strtab.sh_offset < strtab.sh_size) {
+                        return;
+                    }
+                    entries = reinterpret_cast<const Dyn *>(data + dynamic.sh_offset);
+                    count = dynamic.sh_size / sizeof(Dyn);
+                    strings = reinterpret_cast<const char *>(data + strtab.sh_offset);
+                    stringsSize = strtab.sh_size;
+                    break;
+                }
+            }
+            if (!strings) {
+                return;
+            }
+
+            auto string_at = [&](size_t offset) {
+                if (offset >= stringsSize) {
+                    return std::string();
+                }
+                return std::string(strings + offset,
+                                   ::strnlen(strings + offset, stringsSize - offset));
+            };
+            for (size_t i = 0; i < count; ++i) {
+                const auto &entry = entries[i];
+                if (entry.d_tag == DT_NULL) {
+                    break;
+                }
+                if (entry.d_tag == DT_SONAME) {
+                    info.soname = string_at(entry.d_un.d_val);
+                } else if (entry.d_tag == DT_NEEDED) {
+                    info.needed.push_back(string_at(entry.d_un.d_val));
+                }
+            }
+        }
+
+        // Collect the file arguments of GROUP, INPUT and AS_NEEDED commands, other commands
+        // such as OUTPUT_FORMAT or SEARCH_DIR are skipped.
+        // e.g. libm.so: GROUP ( /lib/x86_64-linux-gnu/libm.so.6 AS_NEEDED ( ... ) )
+        static bool read_script(std::string_view text, FileInfo &info) {
+            std::vector<std::string> tokens;
+            for (size_t i = 0; i < text.size();) {
+                char ch = text[i];
+                if (text.compare(i, 2, "/*") == 0) {
+                    auto end = text.find("*/", i + 2);
+                    i = end == std::string_view::npos ? text.size() : end + 2;
+                } else if (ch == '(' || ch == ')') {
+                    tokens.emplace_back(1, ch);
+                    i++;
+                } else if (ch == '"') {
+                    auto end = text.find('"', i + 1);
+                    if (end == std::string_view::npos) {
+                        return false;
+                    }
+                    tokens.emplace_back(text.substr(i + 1, end - i - 1));
+                    i = end + 1;
+                } else if (std::isspace(static_cast<unsigned char>(ch)) || ch == ',' ||
+                           ch == ';') {
+                    i++;
+                } else {
+                    auto end = std::find_if(text.begin() + i, text.end(), [](char c) {
+                        return std::isspace(static_cast<unsigned char>(c)) ||
+                               std::string_view("(),;\"").find(c) != std::string_view::npos;
+                    }) - text.begin();
+                    tokens.emplace_back(text.substr(i, end - i));
+                    i = size_t(end);
+                }
+            }
+
+            bool found = false;
+            int depth = 0;
+            // depth of the GROUP or INPUT being read, 0 if outside
+            int fileDepth = 0;
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                const auto &token = tokens[i];
+                if (token == "(") {
+                    depth++;
+                } else if (token == ")") {
+                    if (depth-- == fileDepth) {
+                        fileDepth = 0;
+                    }
+                } else if (i + 1 < tokens.size() && tokens[i + 1] == "(") {
+                    if (fileDepth == 0 && (token == "GROUP" || token == "INPUT")) {
+                        fileDepth = depth + 1;
+                        found = true;
+                    }
+                    // AS_NEEDED only appears within a file list
+                } else if (fileDepth != 0) {
+                    info.inputs.push_back(token);
+                }
+            }
+            return found;
+        }
+
+        static FileInfo parse(const unsigned char *data, size_t size) {
+            FileInfo info;
+            info.type = "unknown";
+
+            std::string_view head(reinterpret_cast<const char *>(data), std::min<size_t>(size, 8));
+            if (head == "!<arch>\n" || head == "!<thin>\n") {
+                info.type = "static";
+                return info;
+            }
+
+            // e.g. libc.so: GROUP ( /lib/x86_64-linux-gnu/libc.so.6 ... )
+            if (size < EI_NIDENT || std::memcmp(data, ELFMAG, SELFMAG) != 0) {
+                std::string_view text(reinterpret_cast<const char *>(data),
+                                      std::min<size_t>(size, 65536));
+                if (text.find('\0') == std::string_view::npos && read_script(text, info)) {
+                    info.type = "script";
+                }
+                return info;
+            }
+
+            // only the byte order of the host is supported
+            constexpr unsigned char host_data =
+                __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? ELFDATA2LSB : ELFDATA2MSB;
+            if (data[EI_DATA] != host_data) {
+                return info;
+            }
+            if (data[EI_CLASS] == ELFCLASS64) {
+                read_dynamic<Elf64_Ehdr, Elf64_Phdr, Elf64_Shdr, Elf64_Dyn>(data, size, info);
+            } else if (data[EI_CLASS] == ELFCLASS32) {
+                read_dynamic<Elf32_Ehdr, Elf32_Phdr, Elf32_Shdr, Elf32_Dyn>(data, size, info);
+            }
+            return info;
+        }
+
+        // The results are cached by inode and modification time, since the same libraries are
+        // linked by most targets of a package and by most packages of a crawl.
+        static FileInfo read_file(const fs::path &path) {
+            struct CacheEntry {
+                timespec mtime;
+                off_t size;
+                FileInfo info;
+            };
+            static std::map<std::pair<dev_t, ino_t>, CacheEntry> cache;
+            static std::mutex cacheMutex;
+
+            auto same_stat = [](const CacheEntry &entry, const struct stat &st) {
+                return entry.mtime.tv_sec == st.st_mtim.tv_sec &&
+                       entry.mtime.tv_nsec == st.st_mtim.tv_nsec && entry.size == st.st_size;
+            };
+
+            struct stat st;
+            if (::stat(path.c_str(), &st) != 0) {
+                throw std::runtime_error(
+                    stdc::formatN("failed to stat file %1: %2", path, std::strerror(errno)));
+            }
+            auto key = std::make_pair(st.st_dev, st.st_ino);
+            {
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                auto it = cache.find(key);
+                if (it != cache.end() && same_stat(it->second, st)) {
+                    return it->second.info;
+                }
+            }
+
+            FileInfo info;
+            info.type = "unknown";
+            if (st.st_size > 0) {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    throw std::runtime_error(
+                        stdc::formatN("failed to open file %1: %2", path, std::strerror(errno)));
+                }
+                void *addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (addr == MAP_FAILED) {
+                    throw std::runtime_error(
+                        stdc::formatN("failed to map file %1: %2", path, std::strerror(errno)));
+                }
+                info = parse(static_cast<const unsigned char *>(addr), st.st_size);
+                ::munmap(addr, st.st_size);
+            }
+
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            cache[key] = {st.st_mtim, st.st_size, info};
+            return info;
+        }
+
     }
+#endif
 
     static int check_output(const std::filesystem::path &command,
                             const std::vector<std::string> &args, const std::filesystem::path &cwd,
@@ -149,6 +580,168 @@ namespace tool {
         return p.returncode().value_or(-1);
     }
 
+    // Runs `func` for each index in [0, count) on at most `jobs` threads, the first exception
+    // thrown by a task is rethrown after all threads finish.
+    static void parallel_for(size_t count, int jobs, const std::function<void(size_t)> &func) {
+        size_t threadCount = std::min(count, size_t(std::max(jobs, 1)));
+        if (threadCount <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto worker = [&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                try {
+                    func(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+#ifdef __linux__
+    // Watches the parent directories rather than the files themselves, since editors and
+    // installers usually replace a file by renaming, which drops the watch on the old inode.
+    class InputWatcher {
+    public:
+        InputWatcher() {
+            fd = inotify_init1(IN_CLOEXEC);
+            if (fd < 0) {
+                throw std::runtime_error(
+                    stdc::formatN("failed to initialize inotify: %1", std::strerror(errno)));
+            }
+        }
+        ~InputWatcher() {
+            ::close(fd);
+        }
+
+        InputWatcher(const InputWatcher &) = delete;
+        InputWatcher &operator=(const InputWatcher &) = delete;
+
+        // The instance stays alive across updates, so that changes made while a dump is
+        // running are still pending when waiting for the next one.
+        void update(const std::vector<fs::path> &files) {
+            std::map<fs::path, std::set<std::string>> files_by_dir;
+            for (const auto &file : files) {
+                files_by_dir[file.parent_path()].insert(file.filename().string());
+            }
+
+            for (auto it = dirs.begin(); it != dirs.end();) {
+                if (files_by_dir.count(it->second.path)) {
+                    ++it;
+                    continue;
+                }
+                ::inotify_rm_watch(fd, it->first);
+                it = dirs.erase(it);
+            }
+
+            // adding an existing directory again returns the same descriptor
+            for (auto &item : files_by_dir) {
+                int wd = inotify_add_watch(fd, item.first.c_str(),
+                                           IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE |
+                                               IN_MOVED_FROM | IN_MOVED_TO);
+                if (wd < 0) {
+                    warning("failed to watch directory %1: %2", item.first,
+                            std::strerror(errno));
+                    continue;
+                }
+                dirs[wd] = {item.first, std::move(item.second)};
+            }
+        }
+
+        // Blocks until a watched file changes and no further change happens within
+        // `debounce` milliseconds.
+        void wait(int debounce) {
+            bool changed = false;
+            while (true) {
+                pollfd pfd{fd, POLLIN, 0};
+                int ret = ::poll(&pfd, 1, changed ? debounce : -1);
+                if (ret < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error(
+                        stdc::formatN("failed to poll inotify: %1", std::strerror(errno)));
+                }
+                if (ret == 0) {
+                    return;
+                }
+                if (read_events()) {
+                    changed = true;
+                }
+            }
+        }
+
+    private:
+        bool read_events() {
+            alignas(inotify_event) char buf[4096];
+            ssize_t len = ::read(fd, buf, sizeof(buf));
+            if (len < 0) {
+                if (errno == EINTR || errno == EAGAIN) {
+                    return false;
+                }
+                throw std::runtime_error(
+                    stdc::formatN("failed to read inotify: %1", std::strerror(errno)));
+            }
+
+            bool changed = false;
+            for (char *ptr = buf; ptr < buf + len;) {
+                auto event = reinterpret_cast<const inotify_event *>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                // events are lost, assume the worst
+                if (event->mask & IN_Q_OVERFLOW) {
+                    changed = true;
+                    continue;
+                }
+                auto it = dirs.find(event->wd);
+                if (it == dirs.end()) {
+                    continue;
+                }
+                // the directory itself is gone
+                if (event->mask & IN_IGNORED) {
+                    dirs.erase(it);
+                    changed = true;
+                    continue;
+                }
+                if (event->len > 0 && it->second.files.count(event->name)) {
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+
+        struct WatchedDir {
+            fs::path path;
+            std::set<std::string> files;
+        };
+
+        int fd = -1;
+        std::map<int, WatchedDir> dirs;
+    };
+#endif
+
 }
 
 static GlobalContext g_ctx;
@@ -205,8 +798,9 @@ static void check_cmake() {
         static std::regex pattern(R"(cmake version (.+))");
         std::smatch match;
         if (std::regex_search(line, match, pattern)) {
+            g_ctx.cmakeVersion = match[1].str();
             if (g_ctx.verbose) {
-                tool::info("cmake version: %1", match[1].str());
+                tool::info("cmake version: %1", g_ctx.cmakeVersion);
             }
             return;
         }
@@ -249,7 +843,8 @@ static void check_ninja() {
     throw std::runtime_error("check ninja failed: failed to get version");
 }
 
-static void run_cmake_configure() {
+static void run_cmake_configure(const fs::path &dir, const fs::path &script,
+                                const std::vector<std::string> &args = {}) {
     int ret;
     try {
         std::vector<std::string> cmakeArgs = {
@@ -257,16 +852,26 @@ static void run_cmake_configure() {
             ".",
             "-B",
             "build",
-            "-G",
-            "Ninja",
-            "-DCMAKE_MAKE_PROGRAM:FILEPATH=" + stdc::to_string(g_ctx.ninjaPath),
-            "-DXMAKE_FIND_SCRIPT:FILEPATH=" + stdc::to_string(g_ctx.script),
+            "-DXMAKE_FIND_SCRIPT:FILEPATH=" + stdc::to_string(script),
         };
+        if (g_ctx.genex) {
+            // the default generator only evaluates file(GENERATE), nothing is built
+            cmakeArgs.push_back("-DXMAKE_EXTRACT_GENEX:BOOL=ON");
+        } else {
+            cmakeArgs.insert(cmakeArgs.end(),
+                             {
+                                 "-G",
+                                 "Ninja",
+                                 "-DCMAKE_MAKE_PROGRAM:FILEPATH=" +
+                                     stdc::to_string(g_ctx.ninjaPath),
+                             });
+        }
         cmakeArgs.insert(cmakeArgs.end(), g_ctx.extraArgs.begin(), g_ctx.extraArgs.end());
+        cmakeArgs.insert(cmakeArgs.end(), args.begin(), args.end());
         if (g_ctx.verbose) {
             report_subprocess_args(g_ctx.cmakePath, cmakeArgs);
         }
-        ret = tool::execute_process(g_ctx.cmakePath, cmakeArgs, g_ctx.dir, {}, g_ctx.verbose);
+        ret = tool::execute_process(g_ctx.cmakePath, cmakeArgs, dir, {}, g_ctx.verbose);
     } catch (const std::exception &e) {
         throw std::runtime_error(stdc::formatN("execute cmake failed: %1", exception_message(e)));
     }
@@ -280,62 +885,51 @@ static void run_cmake_configure() {
     }
 }
 
-static int cmd_handler(const SCL::ParseResult &result) {
-    if (result.isRoleSet(SCL::Option::Verbose)) {
-        g_ctx.verbose = true;
-    }
-
-    {
-        auto cmakePath = result.valueForOption("--cmake").toString();
-        auto ninjaPath = result.valueForOption("--ninja").toString();
-
-        auto extraArgs = result.option("--").values();
-        auto output = result.valueForOption("-o").toString();
-        auto dir = result.valueForOption("--dir").toString();
-        auto script = result.value("script").toString();
-
-        if (!cmakePath.empty()) {
-            g_ctx.cmakePath = stdc::path::from_utf8(cmakePath);
-        }
-        if (!ninjaPath.empty()) {
-            g_ctx.ninjaPath = stdc::path::from_utf8(ninjaPath);
-        }
-        g_ctx.dir =
-            dir.empty() ? g_ctx.cwd / _TSTR("build") : fs::absolute(stdc::path::from_utf8(dir));
-        if (!output.empty()) {
-            g_ctx.output = stdc::path::from_utf8(output);
-        }
-
-        g_ctx.script = fs::absolute(stdc::path::from_utf8(script));
-
-        if (!extraArgs.empty()) {
-            g_ctx.extraArgs.reserve(extraArgs.size());
-            for (const auto &arg : extraArgs) {
-                g_ctx.extraArgs.push_back(arg.toString());
-            }
-        }
-    }
-
-    // initialize
-    g_ctx.cwd = fs::current_path();
+struct NinjaTarget {
+    // msvc: /D -D
+    // gcc:  -D
+    std::vector<std::string> defines;
+    // gcc: -l
+    std::vector<std::string> links;
+    // msvc: -LIBPATH: /LIBPATH
+    // gcc:  -L
+    std::vector<std::string> linkdirs;
+    // msvc: -I /I -external:I /external:I
+    // gcc:  -I -isystem -idirafter
+    std::vector<std::string> includes;
+    std::vector<std::string> flags;
+    std::vector<std::string> linkflags;
+
+    struct Library {
+        std::string entry;
+        // empty if not found in the search path
+        fs::path path;
+        std::string type;
+        std::string soname;
+        std::vector<std::string> needed;
+        // the files a linker script refers to
+        std::vector<Library> members;
+    };
+    // resolved from links, only with --resolve-links
+    std::vector<Library> libraries;
+};
 
-    // check tools
-    check_cmake();
-    check_ninja();
+using NinjaTargetMap = std::map<std::string, NinjaTarget>;
 
+static void prepare_directory(const fs::path &dir, const fs::path &script) {
     // prepare temporary path
-    if (fs::exists(g_ctx.dir)) {
-        fs::remove_all(g_ctx.dir);
+    if (fs::exists(dir)) {
+        fs::remove_all(dir);
     }
-    fs::create_directory(g_ctx.dir);
+    fs::create_directories(dir);
 
     // check script file
-    if (!fs::exists(g_ctx.script)) {
-        throw std::runtime_error(stdc::formatN("failed to read file: %1", g_ctx.script));
+    if (!fs::exists(script)) {
+        throw std::runtime_error(stdc::formatN("failed to read file: %1", script));
     }
 
     // create CMakeLists.txt
-    fs::path cmakeListsPath = g_ctx.dir / _TSTR("CMakeLists.txt");
+    fs::path cmakeListsPath = dir / _TSTR("CMakeLists.txt");
     {
         std::ofstream cmakeListsFile(cmakeListsPath,
                                      std::ios::out | std::ios::trunc | std::ios::binary);
@@ -346,7 +940,7 @@ static int cmd_handler(const SCL::ParseResult &result) {
     }
 
     // create TestTargets.cmake
-    fs::path testTargetsCMakePath = g_ctx.dir / _TSTR("TestTargets.cmake");
+    fs::path testTargetsCMakePath = dir / _TSTR("TestTargets.cmake");
     {
         std::ofstream testTargetsCMakeFile(testTargetsCMakePath,
                                            std::ios::out | std::ios::trunc | std::ios::binary);
@@ -357,50 +951,57 @@ static int cmd_handler(const SCL::ParseResult &result) {
         testTargetsCMakeFile.write((const char *) TestTargets_cmake_data.data,
                                    TestTargets_cmake_data.size);
     }
+}
 
-    // execute CMake
-    run_cmake_configure();
+static std::vector<std::string> read_lines(const fs::path &path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(stdc::formatN("failed to open file: %1", path));
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
 
+static std::string read_cache_compiler(const fs::path &build_dir) {
     // analyze CMakeCache.txt
-    fs::path build_dir = g_ctx.dir / _TSTR("build");
-    bool is_msvc = false;
-    {
-        std::ifstream cache(build_dir / _TSTR("CMakeCache.txt"));
-        std::string line;
-        while (std::getline(cache, line)) {
-            std::string_view line_view = line;
-            if (stdc::starts_with(line_view, "CMAKE_CXX_COMPILER")) {
-                auto eq_pos = line_view.find('=');
-                if (eq_pos != std::string::npos) {
-                    auto compiler = stdc::trim(line_view.substr(eq_pos + 1));
-                    auto basename = fs::path(stdc::path::from_utf8(compiler)).stem();
-                    if (stdc::to_lower(basename) == _TSTR("cl"))
-                        is_msvc = true;
-                }
-                break;
+    std::ifstream cache(build_dir / _TSTR("CMakeCache.txt"));
+    std::string line;
+    while (std::getline(cache, line)) {
+        std::string_view line_view = line;
+        if (stdc::starts_with(line_view, "CMAKE_CXX_COMPILER")) {
+            auto eq_pos = line_view.find('=');
+            if (eq_pos != std::string::npos) {
+                return std::string(stdc::trim(line_view.substr(eq_pos + 1)));
             }
+            break;
         }
     }
+    return {};
+}
 
-    struct NinjaTarget {
-        // msvc: /D -D
-        // gcc:  -D
-        std::vector<std::string> defines;
-        // gcc: -l
-        std::vector<std::string> links;
-        // msvc: -LIBPATH: /LIBPATH
-        // gcc:  -L
-        std::vector<std::string> linkdirs;
-        // msvc: -I /I -external:I /external:I
-        // gcc:  -I -isystem -idirafter
-        std::vector<std::string> includes;
-        std::vector<std::string> flags;
-        std::vector<std::string> linkflags;
-    };
-    std::map<std::string, NinjaTarget> targets;
+static bool detect_msvc(const fs::path &build_dir) {
+    auto compiler = read_cache_compiler(build_dir);
+    if (compiler.empty()) {
+        return false;
+    }
+    auto basename = fs::path(stdc::path::from_utf8(compiler)).stem();
+    return stdc::to_lower(basename) == _TSTR("cl");
+}
+
+static NinjaTargetMap parse_build_ninja(const fs::path &build_dir, bool is_msvc) {
+    NinjaTargetMap targets;
 
     // analyze build.ninja
-    fs::path ninjaFilePath = g_ctx.dir / _TSTR("build") / _TSTR("build.ninja");
+    fs::path ninjaFilePath = build_dir / _TSTR("build.ninja");
     {
         std::ifstream ninjaFile(ninjaFilePath);
         if (!ninjaFile.is_open()) {
@@ -593,74 +1194,1129 @@ static int cmd_handler(const SCL::ParseResult &result) {
             }
         }
     }
+    return targets;
+}
 
-    // print ninja targets
-    if (g_ctx.verbose) {
-        tool::debug("Auxiliary Targets:");
-        for (const auto &target : targets) {
-            tool::info("TARGET %1:", target.first);
-            const auto &t = target.second;
-            if (!t.defines.empty()) {
-                tool::info("  DEFINES:");
-                for (const auto &define : t.defines) {
-                    tool::info("    %1", define);
-                }
-            }
-            if (!t.links.empty()) {
-                tool::info("  LINKS:");
-                for (const auto &link : t.links) {
-                    tool::info("    %1", link);
-                }
+static NinjaTargetMap parse_usage_files(const fs::path &build_dir, bool is_msvc) {
+    NinjaTargetMap targets;
+
+    // analyze usages/*.txt written by file(GENERATE)
+    // e.g.
+    //      INCLUDE	/usr/include/foo
+    //      LINK	/usr/lib/libfoo.so
+    //      LINKGENEX	dl
+    fs::path usagesDir = build_dir / _TSTR("usages");
+    if (!fs::is_directory(usagesDir)) {
+        return targets;
+    }
+    for (const auto &entry : fs::directory_iterator(usagesDir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != _TSTR(".txt")) {
+            continue;
+        }
+
+        auto &target = targets[entry.path().stem().string()];
+        for (const auto &line : read_lines(entry.path())) {
+            auto tab_idx = line.find('\t');
+            if (tab_idx == std::string::npos || tab_idx + 1 == line.size()) {
+                continue;
             }
-            if (!t.linkdirs.empty()) {
-                tool::info("  LINK_DIRS:");
-                for (const auto &linkdir : t.linkdirs) {
-                    tool::info("    %1", linkdir);
+            std::string_view key = std::string_view(line).substr(0, tab_idx);
+            std::string value = line.substr(tab_idx + 1);
+
+            // keep the values consistent with the ones parsed from build.ninja
+            if (key == "DEFINE") {
+                if (stdc::starts_with(value, "-D")) {
+                    value = value.substr(2);
                 }
-            }
-            if (!t.includes.empty()) {
-                tool::info("  INCLUDE_DIRS:");
-                for (const auto &include : t.includes) {
-                    tool::info("    %1", include);
+                target.defines.push_back(value);
+            } else if (key == "INCLUDE") {
+                target.includes.push_back(value);
+            } else if (key == "LINKDIR") {
+                target.linkdirs.push_back(value);
+            } else if (key == "LINK") {
+                if (!is_msvc && stdc::starts_with(value, "-l")) {
+                    value = value.substr(2);
                 }
-            }
-            if (!t.flags.empty()) {
-                tool::info("  FLAGS:");
-                for (const auto &flag : t.flags) {
-                    tool::info("    %1", flag);
+                target.links.push_back(value);
+            } else if (key == "LINKGENEX") {
+                // items left conditional by CMake, they are evaluated as plain strings so
+                // a target name here can not be resolved to its file
+                size_t start = 0;
+                while (start <= value.size()) {
+                    size_t end = value.find(';', start);
+                    if (end == std::string::npos) {
+                        end = value.size();
+                    }
+                    std::string item = value.substr(start, end - start);
+                    start = end + 1;
+                    if (item.empty()) {
+                        continue;
+                    }
+                    if (item.find("::") != std::string::npos) {
+                        tool::warning("%1: drop unresolved link target %2",
+                                      entry.path().stem().string(), item);
+                        continue;
+                    }
+                    if (!is_msvc && stdc::starts_with(item, "-l")) {
+                        item = item.substr(2);
+                    }
+                    target.links.push_back(item);
                 }
-            }
-            if (!t.linkflags.empty()) {
-                tool::info("  LINK_FLAGS:");
-                for (const auto &linkflag : t.linkflags) {
-                    tool::info("    %1", linkflag);
+            } else if (key == "FLAG" || key == "LINKFLAG") {
+                auto &list = key == "FLAG" ? target.flags : target.linkflags;
+                if (stdc::starts_with(value, "SHELL:")) {
+                    auto items = stdc::system::split_command_line(value.substr(6));
+                    list.insert(list.end(), items.begin(), items.end());
+                } else {
+                    list.push_back(value);
                 }
             }
         }
     }
+    return targets;
+}
 
-    return 0;
+static NinjaTargetMap read_targets(const fs::path &build_dir) {
+    bool is_msvc = detect_msvc(build_dir);
+    return g_ctx.genex ? parse_usage_files(build_dir, is_msvc)
+                       : parse_build_ninja(build_dir, is_msvc);
 }
 
-#include <stdcorelib/support/popen.h>
+static void print_targets(const NinjaTargetMap &targets) {
+    tool::debug("Auxiliary Targets:");
+    for (const auto &target : targets) {
+        tool::info("TARGET %1:", target.first);
+        const auto &t = target.second;
+        if (!t.defines.empty()) {
+            tool::info("  DEFINES:");
+            for (const auto &define : t.defines) {
+                tool::info("    %1", define);
+            }
+        }
+        if (!t.links.empty()) {
+            tool::info("  LINKS:");
+            for (const auto &link : t.links) {
+                tool::info("    %1", link);
+            }
+        }
+        if (!t.linkdirs.empty()) {
+            tool::info("  LINK_DIRS:");
+            for (const auto &linkdir : t.linkdirs) {
+                tool::info("    %1", linkdir);
+            }
+        }
+        if (!t.includes.empty()) {
+            tool::info("  INCLUDE_DIRS:");
+            for (const auto &include : t.includes) {
+                tool::info("    %1", include);
+            }
+        }
+        if (!t.flags.empty()) {
+            tool::info("  FLAGS:");
+            for (const auto &flag : t.flags) {
+                tool::info("    %1", flag);
+            }
+        }
+        if (!t.linkflags.empty()) {
+            tool::info("  LINK_FLAGS:");
+            for (const auto &linkflag : t.linkflags) {
+                tool::info("    %1", linkflag);
+            }
+        }
+        if (!t.libraries.empty()) {
+            tool::info("  LIBRARIES:");
+            for (const auto &library : t.libraries) {
+                tool::info("    %1 -> %2 (%3)", library.entry, library.path, library.type);
+            }
+        }
+    }
+}
 
-int main(int argc, char *argv[]) {
-    (void) argc;
-    (void) argv;
+struct PackageTarget {
+    std::string name;
+    // the size of the target's link closure, which dominates its configuration cost
+    size_t weight;
+};
 
-    // try {
-    //     stdc::Popen proc;
-    //     proc.args({
-    //              "git",
-    //             "clone",
-    //             "--recursive",
-    //             "https://github.com/stdware/qwindowkit.git",
-    //         })
-    //         .stdout_(stdout)
-    //         .stderr_(stdc::Popen::STDOUT);
-    //     proc.done();
-    //     int code = proc.wait();
-    //     tool::success("Process exit with code %1", code);
+static std::vector<PackageTarget> list_package_targets(const fs::path &dir,
+                                                       const fs::path &script) {
+    // configure without the auxiliary executables, only the target list is written
+    prepare_directory(dir, script);
+    run_cmake_configure(dir, script, {"-DXMAKE_LIST_TARGETS:BOOL=ON"});
+
+    fs::path build_dir = dir / _TSTR("build");
+    auto names = read_lines(build_dir / _TSTR("list_targets.txt"));
+
+    // e.g.
+    //      Foo::Core
+    //      \tFoo::Base
+    //      \t$<LINK_ONLY:Foo::Private>
+    std::map<std::string, std::vector<std::string>> deps;
+    {
+        std::string current;
+        for (const auto &line : read_lines(build_dir / _TSTR("target_deps.txt"))) {
+            if (line.front() != '\t') {
+                current = line;
+                deps[current];
+                continue;
+            }
+            std::string_view dep = std::string_view(line).substr(1);
+            if (stdc::starts_with(dep, "$<LINK_ONLY:") && stdc::ends_with(dep, ">")) {
+                dep = dep.substr(12, dep.size() - 13);
+            }
+            if (!current.empty()) {
+                deps[current].emplace_back(dep);
+            }
+        }
+    }
+
+    std::vector<PackageTarget> result;
+    result.reserve(names.size());
+    for (const auto &name : names) {
+        std::set<std::string> visited;
+        std::vector<std::string> stack = {name};
+        while (!stack.empty()) {
+            auto current = std::move(stack.back());
+            stack.pop_back();
+            auto it = deps.find(current);
+            if (it == deps.end() || !visited.insert(current).second) {
+                continue;
+            }
+            stack.insert(stack.end(), it->second.begin(), it->second.end());
+        }
+        result.push_back({name, std::max<size_t>(visited.size(), 1)});
+    }
+    return result;
+}
+
+static std::vector<std::vector<std::string>>
+    partition_targets(std::vector<PackageTarget> targets, size_t count) {
+    // longest processing time first: place the heaviest remaining target on the lightest shard
+    std::sort(targets.begin(), targets.end(), [](const PackageTarget &a, const PackageTarget &b) {
+        return a.weight != b.weight ? a.weight > b.weight : a.name < b.name;
+    });
+
+    std::vector<std::vector<std::string>> shards(std::min(count, targets.size()));
+    std::vector<size_t> loads(shards.size());
+    for (const auto &target : targets) {
+        auto idx = std::min_element(loads.begin(), loads.end()) - loads.begin();
+        shards[idx].push_back(target.name);
+        loads[idx] += target.weight;
+    }
+    return shards;
+}
+
+static NinjaTargetMap dump_package_sharded(const fs::path &dir, const fs::path &script,
+                                           int jobs) {
+    auto shards = partition_targets(list_package_targets(dir, script), jobs);
+    if (g_ctx.verbose) {
+        tool::debug("Dump %1 shards:", shards.size());
+        for (size_t i = 0; i < shards.size(); ++i) {
+            tool::info("  shard %1: %2 targets", i, shards[i].size());
+        }
+    }
+
+    std::vector<NinjaTargetMap> results(shards.size());
+    tool::parallel_for(shards.size(), jobs, [&](size_t i) {
+        std::string filter;
+        for (const auto &name : shards[i]) {
+            if (!filter.empty()) {
+                filter += ';';
+            }
+            filter += name;
+        }
+
+        fs::path shard_dir = dir / _TSTR("shards") / std::to_string(i);
+        prepare_directory(shard_dir, script);
+        run_cmake_configure(shard_dir, script, {"-DXMAKE_DUMP_TARGETS:STRING=" + filter});
+
+        results[i] = read_targets(shard_dir / _TSTR("build"));
+    });
+
+    NinjaTargetMap targets;
+    for (auto &result : results) {
+        targets.merge(result);
+    }
+    return targets;
+}
+
+#ifdef __linux__
+static std::vector<fs::path> compiler_search_dirs(const fs::path &build_dir) {
+    static std::map<std::string, std::vector<fs::path>> cache;
+    static std::mutex cacheMutex;
+
+    auto compiler = read_cache_compiler(build_dir);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(compiler);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    // execute: <compiler> -print-search-dirs
+    // expected output:
+    // ```
+    // install: ...
+    // programs: =...
+    // libraries: =/usr/lib/gcc/x86_64-linux-gnu/12/:/lib/x86_64-linux-gnu/:...
+    // ```
+    std::vector<fs::path> dirs;
+    try {
+        std::string output;
+        if (!compiler.empty() &&
+            tool::check_output(stdc::path::from_utf8(compiler), {"-print-search-dirs"}, {}, {},
+                               output) == 0) {
+            std::istringstream is(output);
+            std::string line;
+            while (std::getline(is, line)) {
+                if (!stdc::starts_with(line, "libraries: =")) {
+                    continue;
+                }
+                std::string_view paths = std::string_view(line).substr(12);
+                while (!paths.empty()) {
+                    auto colon_idx = paths.find(':');
+                    auto path = paths.substr(0, colon_idx);
+                    if (!path.empty()) {
+                        dirs.push_back(fs::path(std::string(path)).lexically_normal());
+                    }
+                    if (colon_idx == std::string_view::npos) {
+                        break;
+                    }
+                    paths.remove_prefix(colon_idx + 1);
+                }
+            }
+        }
+    } catch (const std::exception &e) {
+        tool::warning("failed to query search dirs of %1: %2", compiler, exception_message(e));
+    }
+    if (dirs.empty()) {
+        dirs = {"/usr/local/lib", "/lib64", "/lib", "/usr/lib64", "/usr/lib"};
+    }
+    cache[compiler] = dirs;
+    return dirs;
+}
+
+static NinjaTarget::Library resolve_link(const std::string &entry,
+                                         const std::vector<fs::path> &dirs,
+                                         const fs::path &build_dir, int depth = 0) {
+    NinjaTarget::Library library;
+    library.entry = entry;
+    library.type = "missing";
+
+    std::error_code ec;
+    if (entry.find('/') != std::string::npos) {
+        // a path is relative to the build directory, where the linker runs
+        fs::path path = stdc::path::from_utf8(entry);
+        if (path.is_relative()) {
+            path = build_dir / path;
+        }
+        if (fs::is_regular_file(path, ec)) {
+            library.path = path.lexically_normal();
+        }
+    } else {
+        // -l:<file> searches for the exact file name, -l<name> prefers the shared library
+        // within each directory before moving on to the next one
+        std::vector<std::string> names;
+        if (stdc::starts_with(entry, ":")) {
+            names = {entry.substr(1)};
+        } else {
+            names = {"lib" + entry + ".so", "lib" + entry + ".a"};
+        }
+        for (const auto &dir : dirs) {
+            for (const auto &name : names) {
+                fs::path path = dir / name;
+                if (fs::is_regular_file(path, ec)) {
+                    library.path = path;
+                    break;
+                }
+            }
+            if (!library.path.empty()) {
+                break;
+            }
+        }
+    }
+    if (library.path.empty()) {
+        return library;
+    }
+
+    try {
+        auto info = tool::elf::read_file(library.path);
+        library.type = std::move(info.type);
+        library.soname = std::move(info.soname);
+        library.needed = std::move(info.needed);
+
+        // follow the script like the linker does, a script may refer to another one
+        if (library.type == "script" && depth < 8) {
+            for (const auto &input : info.inputs) {
+                std::string member = input;
+                if (stdc::starts_with(member, "-l")) {
+                    member = member.substr(2);
+                } else if (member.find('/') == std::string::npos) {
+                    member = ":" + member;
+                }
+                library.members.push_back(resolve_link(member, dirs, build_dir, depth + 1));
+                library.members.back().entry = input;
+            }
+        }
+    } catch (const std::exception &e) {
+        tool::warning("failed to read library %1: %2", library.path, exception_message(e));
+        library.type = "unknown";
+    }
+    return library;
+}
+#endif
+
+static void resolve_link_files(NinjaTargetMap &targets, const fs::path &build_dir, int jobs) {
+#ifdef __linux__
+    if (detect_msvc(build_dir)) {
+        tool::warning("link resolution is not supported for MSVC");
+        return;
+    }
+
+    auto defaultDirs = compiler_search_dirs(build_dir);
+
+    struct Task {
+        NinjaTarget *target;
+        size_t index;
+    };
+    std::vector<Task> tasks;
+    std::map<NinjaTarget *, std::vector<fs::path>> searchDirs;
+    for (auto &item : targets) {
+        auto &target = item.second;
+        target.libraries.clear();
+
+        // flags such as -pthread or -Wl,... are not files
+        for (const auto &link : target.links) {
+            if (link.empty() || link.front() == '-') {
+                continue;
+            }
+            tasks.push_back({&target, target.libraries.size()});
+            target.libraries.emplace_back().entry = link;
+        }
+
+        auto &dirs = searchDirs[&target];
+        for (const auto &linkdir : target.linkdirs) {
+            fs::path dir = stdc::path::from_utf8(linkdir);
+            dirs.push_back(dir.is_relative() ? build_dir / dir : dir);
+        }
+        dirs.insert(dirs.end(), defaultDirs.begin(), defaultDirs.end());
+    }
+
+    tool::parallel_for(tasks.size(), jobs, [&](size_t i) {
+        auto &library = tasks[i].target->libraries[tasks[i].index];
+        library = resolve_link(library.entry, searchDirs.at(tasks[i].target), build_dir);
+    });
+#else
+    (void) targets;
+    (void) build_dir;
+    (void) jobs;
+    tool::warning("link resolution is only supported on Linux");
+#endif
+}
+
+static NinjaTargetMap dump_package(const fs::path &dir, const fs::path &script, int jobs) {
+    NinjaTargetMap targets;
+    if (jobs > 1) {
+        targets = dump_package_sharded(dir, script, jobs);
+    } else {
+        // prepare temporary path
+        prepare_directory(dir, script);
+
+        // execute CMake
+        run_cmake_configure(dir, script);
+
+        targets = read_targets(dir / _TSTR("build"));
+    }
+
+    // the listing tree of a sharded dump holds a cache with the same compiler
+    if (g_ctx.resolveLinks) {
+        resolve_link_files(targets, dir / _TSTR("build"), jobs);
+    }
+
+    // print ninja targets
+    if (g_ctx.verbose) {
+        print_targets(targets);
+    }
+    return targets;
+}
+
+static void serialize_string_list(std::ostream &os, const char *key,
+                                  const std::vector<std::string> &list, bool last) {
+    os << "            \"" << key << "\": [";
+    for (size_t i = 0; i < list.size(); ++i) {
+        os << (i == 0 ? "\n" : ",\n") << "                \"" << tool::json::escape(list[i])
+           << "\"";
+    }
+    os << (list.empty() ? "]" : "\n            ]") << (last ? "\n" : ",\n");
+}
+
+static void serialize_libraries(std::ostream &os,
+                                const std::vector<NinjaTarget::Library> &libraries,
+                                const std::string &key = "libraries", int level = 3) {
+    std::string indent(level * 4, ' ');
+    os << indent << "\"" << key << "\": [";
+    for (size_t i = 0; i < libraries.size(); ++i) {
+        const auto &library = libraries[i];
+        os << (i == 0 ? "\n" : ",\n");
+        os << indent << "    {\n";
+        os << indent << "        \"entry\": \"" << tool::json::escape(library.entry) << "\",\n";
+        os << indent << "        \"path\": \""
+           << tool::json::escape(stdc::to_string(library.path)) << "\",\n";
+        os << indent << "        \"type\": \"" << library.type << "\",\n";
+        os << indent << "        \"soname\": \"" << tool::json::escape(library.soname)
+           << "\",\n";
+        os << indent << "        \"needed\": [";
+        for (size_t j = 0; j < library.needed.size(); ++j) {
+            os << (j == 0 ? "" : ", ") << "\"" << tool::json::escape(library.needed[j]) << "\"";
+        }
+        os << "],\n";
+        serialize_libraries(os, library.members, "members", level + 2);
+        os << indent << "    }";
+    }
+    os << (libraries.empty() ? "]\n" : "\n" + indent + "]\n");
+}
+
+static std::string serialize_targets(const NinjaTargetMap &targets) {
+    std::ostringstream os;
+    os << "{\n";
+    os << "    \"targets\": {";
+    bool first = true;
+    for (const auto &target : targets) {
+        const auto &t = target.second;
+        os << (first ? "\n" : ",\n");
+        os << "        \"" << tool::json::escape(target.first) << "\": {\n";
+        serialize_string_list(os, "defines", t.defines, false);
+        serialize_string_list(os, "links", t.links, false);
+        serialize_string_list(os, "linkdirs", t.linkdirs, false);
+        serialize_string_list(os, "includes", t.includes, false);
+        serialize_string_list(os, "flags", t.flags, false);
+        serialize_string_list(os, "linkflags", t.linkflags, !g_ctx.resolveLinks);
+        if (g_ctx.resolveLinks) {
+            serialize_libraries(os, t.libraries);
+        }
+        os << "        }";
+        first = false;
+    }
+    os << (targets.empty() ? "}\n" : "\n    }\n");
+    os << "}\n";
+    return os.str();
+}
+
+static void write_file_atomically(const fs::path &path, const std::string &content) {
+    // write to a sibling file and rename it, so that readers never observe a partial dump
+    fs::path tempPath = path;
+    tempPath += _TSTR(".tmp");
+    {
+        std::ofstream outputFile(tempPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!outputFile.is_open()) {
+            throw std::runtime_error(stdc::formatN("failed to open file: %1", tempPath));
+        }
+        outputFile.write(content.data(), content.size());
+        outputFile.close();
+        if (!outputFile) {
+            throw std::runtime_error(stdc::formatN("failed to write file: %1", tempPath));
+        }
+    }
+    fs::rename(tempPath, path);
+}
+
+static void write_output(const std::string &content) {
+    if (g_ctx.output.empty()) {
+        std::cout << content;
+        std::cout.flush();
+        return;
+    }
+    write_file_atomically(g_ctx.output, content);
+}
+
+static inline bool is_subpath(const fs::path &path, const fs::path &base) {
+    auto rel = path.lexically_relative(base);
+    return !rel.empty() && *rel.begin() != _TSTR("..");
+}
+
+static std::vector<fs::path> collect_watch_inputs() {
+    // the RERUN_CMAKE statement lists every file read by the configuration, the files
+    // generated in the temporary directory are skipped since each dump rewrites them
+    fs::path build_dir = g_ctx.dir / _TSTR("build");
+    auto inputs = tool::ninja::read_cmake_inputs(build_dir / _TSTR("build.ninja"), build_dir);
+
+    std::vector<fs::path> result;
+    result.reserve(inputs.size());
+    for (const auto &input : inputs) {
+        if (is_subpath(input, g_ctx.dir)) {
+            continue;
+        }
+        result.push_back(input);
+    }
+    return result;
+}
+
+using InputTimes = std::map<fs::path, fs::file_time_type>;
+
+static InputTimes record_input_times(const std::vector<fs::path> &inputs) {
+    InputTimes result;
+    for (const auto &input : inputs) {
+        std::error_code ec;
+        auto time = fs::last_write_time(input, ec);
+        if (!ec) {
+            result[input] = time;
+        }
+    }
+    return result;
+}
+
+static bool inputs_modified_during_dump(const std::vector<fs::path> &inputs,
+                                        const InputTimes &before, fs::file_time_type start,
+                                        fs::file_time_type end) {
+    for (const auto &input : inputs) {
+        // a removed input is reported by the watcher
+        std::error_code ec;
+        auto time = fs::last_write_time(input, ec);
+        if (ec) {
+            continue;
+        }
+
+        // the modification times may lie in the future, so the recorded ones are compared
+        // and the clock is only used for the inputs that the dump found first, with a margin
+        // for the coarse timestamps of the file system
+        auto it = before.find(input);
+        if (it != before.end() ? time != it->second
+                               : (time >= start - std::chrono::milliseconds(100) && time <= end)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void watch_package(std::vector<fs::path> inputs, InputTimes inputTimes,
+                          fs::file_time_type dumpStart, fs::file_time_type dumpEnd) {
+#ifdef __linux__
+    tool::InputWatcher watcher;
+    while (true) {
+        watcher.update(inputs);
+
+        // the watches of new inputs are armed after the dump, catch up with the changes made
+        // while it was running
+        if (!inputs_modified_during_dump(inputs, inputTimes, dumpStart, dumpEnd)) {
+            if (g_ctx.verbose) {
+                tool::debug("Watching %1 files for changes...", inputs.size());
+            }
+            watcher.wait(g_ctx.debounce);
+        }
+
+        // keep watching the previous inputs if the package is broken for a while
+        inputTimes = record_input_times(inputs);
+        dumpStart = fs::file_time_type::clock::now();
+        try {
+            auto targets = dump_package(g_ctx.dir, g_ctx.script, g_ctx.jobs);
+            write_output(serialize_targets(targets));
+            inputs = collect_watch_inputs();
+        } catch (const std::exception &e) {
+            std::string msg = exception_message(e);
+            tool::critical("Error: %1", msg);
+        }
+        dumpEnd = fs::file_time_type::clock::now();
+    }
+#else
+    (void) inputs;
+    (void) inputTimes;
+    (void) dumpStart;
+    (void) dumpEnd;
+    throw std::runtime_error("watch mode is only supported on Linux");
+#endif
+}
+
+static void parse_common_options(const SCL::ParseResult &result) {
+    if (result.isRoleSet(SCL::Option::Verbose)) {
+        g_ctx.verbose = true;
+    }
+
+    // initialize
+    g_ctx.cwd = fs::current_path();
+
+    auto cmakePath = result.valueForOption("--cmake").toString();
+    auto ninjaPath = result.valueForOption("--ninja").toString();
+
+    auto extraArgs = result.option("--").values();
+    auto output = result.valueForOption("-o").toString();
+    auto dir = result.valueForOption("--dir").toString();
+    auto jobs = result.valueForOption("--jobs").toString();
+
+    if (!cmakePath.empty()) {
+        g_ctx.cmakePath = stdc::path::from_utf8(cmakePath);
+    }
+    if (!ninjaPath.empty()) {
+        g_ctx.ninjaPath = stdc::path::from_utf8(ninjaPath);
+    }
+    g_ctx.dir =
+        dir.empty() ? g_ctx.cwd / _TSTR("build") : fs::absolute(stdc::path::from_utf8(dir));
+    if (!output.empty()) {
+        g_ctx.output = stdc::path::from_utf8(output);
+    }
+
+    if (!extraArgs.empty()) {
+        g_ctx.extraArgs.reserve(extraArgs.size());
+        for (const auto &arg : extraArgs) {
+            g_ctx.extraArgs.push_back(arg.toString());
+        }
+    }
+
+    g_ctx.genex = result.optionIsSet("--genex");
+    g_ctx.resolveLinks = result.optionIsSet("--resolve-links");
+    if (!jobs.empty()) {
+        try {
+            g_ctx.jobs = std::stoi(jobs);
+        } catch (const std::exception &) {
+            g_ctx.jobs = 0;
+        }
+        if (g_ctx.jobs < 1) {
+            throw std::runtime_error(stdc::formatN("invalid number of jobs: %1", jobs));
+        }
+    }
+}
+
+static int cmd_handler(const SCL::ParseResult &result) {
+    parse_common_options(result);
+
+    {
+        auto script = result.value("script").toString();
+        auto debounce = result.valueForOption("--debounce").toString();
+
+        g_ctx.script = fs::absolute(stdc::path::from_utf8(script));
+
+        g_ctx.watch = result.optionIsSet("--watch");
+        if (!debounce.empty()) {
+            try {
+                g_ctx.debounce = std::stoi(debounce);
+            } catch (const std::exception &) {
+                g_ctx.debounce = -1;
+            }
+            if (g_ctx.debounce < 0) {
+                throw std::runtime_error(stdc::formatN("invalid debounce interval: %1", debounce));
+            }
+        }
+    }
+
+#ifndef __linux__
+    if (g_ctx.watch) {
+        throw std::runtime_error("watch mode is only supported on Linux");
+    }
+#endif
+
+    // watch inputs are read from build.ninja
+    if (g_ctx.watch && g_ctx.genex) {
+        throw std::runtime_error("watch mode is not supported with --genex");
+    }
+
+    // check tools
+    check_cmake();
+    if (!g_ctx.genex) {
+        check_ninja();
+    }
+
+    // the inputs of a previous configuration in the same directory are known in advance
+    InputTimes inputTimes;
+    if (g_ctx.watch && fs::is_regular_file(g_ctx.dir / _TSTR("build") / _TSTR("build.ninja"))) {
+        inputTimes = record_input_times(collect_watch_inputs());
+    }
+
+    auto dumpStart = fs::file_time_type::clock::now();
+    auto targets = dump_package(g_ctx.dir, g_ctx.script, g_ctx.jobs);
+    write_output(serialize_targets(targets));
+    auto dumpEnd = fs::file_time_type::clock::now();
+
+    if (g_ctx.watch) {
+        watch_package(collect_watch_inputs(), std::move(inputTimes), dumpStart, dumpEnd);
+    }
+    return 0;
+}
+
+struct CrawlPackage {
+    std::string name;
+    // the *Config.cmake or *-config.cmake file
+    fs::path config;
+    std::string stamp;
+};
+
+static std::vector<fs::path> list_subdirectories(const fs::path &dir) {
+    std::vector<fs::path> result;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            result.push_back(it->path());
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static std::vector<fs::path> crawl_candidate_dirs(const fs::path &prefix) {
+    // https://cmake.org/cmake/help/latest/command/find_package.html#config-mode-search-procedure
+    // e.g.
+    //      <prefix>/
+    //      <prefix>/(cmake|CMake)/
+    //      <prefix>/<name>*/
+    //      <prefix>/<name>*/(cmake|CMake)/
+    //      <prefix>/(lib/<arch>|lib*|share)/cmake/<name>*/
+    //      <prefix>/(lib/<arch>|lib*|share)/<name>*/
+    //      <prefix>/(lib/<arch>|lib*|share)/<name>*/(cmake|CMake)/
+    std::vector<fs::path> dirs = {
+        prefix,
+        prefix / _TSTR("cmake"),
+        prefix / _TSTR("CMake"),
+    };
+    auto add_package_dirs = [&dirs](const fs::path &base) {
+        for (const auto &dir : list_subdirectories(base)) {
+            dirs.push_back(dir);
+            dirs.push_back(dir / _TSTR("cmake"));
+            dirs.push_back(dir / _TSTR("CMake"));
+        }
+    };
+
+    add_package_dirs(prefix);
+    for (const auto &base : list_subdirectories(prefix)) {
+        auto name = base.filename().string();
+        bool is_lib = stdc::starts_with(name, "lib");
+        if (!is_lib && name != "share") {
+            continue;
+        }
+        for (const auto &dir : list_subdirectories(base / _TSTR("cmake"))) {
+            dirs.push_back(dir);
+        }
+        add_package_dirs(base);
+        if (is_lib) {
+            for (const auto &arch : list_subdirectories(base)) {
+                for (const auto &dir : list_subdirectories(arch / _TSTR("cmake"))) {
+                    dirs.push_back(dir);
+                }
+            }
+        }
+    }
+    return dirs;
+}
+
+static std::string crawl_package_name(const fs::path &file) {
+    auto filename = file.filename().string();
+    for (std::string_view suffix : {"Config.cmake", "-config.cmake"}) {
+        if (filename.size() > suffix.size() && stdc::ends_with(filename, suffix)) {
+            // skip helpers like "LLVM-Config.cmake"
+            auto name = filename.substr(0, filename.size() - suffix.size());
+            return name.back() == '-' ? std::string() : name;
+        }
+    }
+    return {};
+}
+
+static std::vector<CrawlPackage> crawl_packages(const std::vector<fs::path> &prefixes) {
+    std::vector<std::vector<fs::path>> dirsByPrefix(prefixes.size());
+    tool::parallel_for(prefixes.size(), g_ctx.jobs,
+                       [&](size_t i) { dirsByPrefix[i] = crawl_candidate_dirs(prefixes[i]); });
+
+    std::vector<fs::path> dirs;
+    {
+        std::set<fs::path> visited;
+        for (const auto &prefixDirs : dirsByPrefix) {
+            for (const auto &dir : prefixDirs) {
+                if (visited.insert(dir.lexically_normal()).second) {
+                    dirs.push_back(dir);
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<CrawlPackage>> packagesByDir(dirs.size());
+    tool::parallel_for(dirs.size(), g_ctx.jobs, [&](size_t i) {
+        std::vector<fs::path> files;
+        std::error_code ec;
+        for (fs::directory_iterator it(dirs[i], ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                files.push_back(it->path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const auto &file : files) {
+            auto name = crawl_package_name(file);
+            if (!name.empty()) {
+                packagesByDir[i].push_back({name, file, {}});
+            }
+        }
+    });
+
+    // the first match in prefix order wins, like find_package()
+    std::vector<CrawlPackage> result;
+    std::set<std::string> names;
+    for (auto &packages : packagesByDir) {
+        for (auto &package : packages) {
+            if (names.insert(package.name).second) {
+                result.push_back(std::move(package));
+            }
+        }
+    }
+    return result;
+}
+
+static std::string hash_strings(const std::vector<std::string> &items) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto &item : items) {
+        for (unsigned char ch : item) {
+            hash = (hash ^ ch) * 1099511628211ull;
+        }
+        hash = (hash ^ '\n') * 1099511628211ull;
+    }
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long) hash);
+    return buf;
+}
+
+static std::string crawl_package_stamp(const fs::path &config) {
+    // the config file and its siblings, e.g. *ConfigVersion.cmake and *Targets-*.cmake
+    std::vector<std::string> items = {stdc::to_string(config)};
+    std::error_code ec;
+    for (fs::directory_iterator it(config.parent_path(), ec), end; !ec && it != end;
+         it.increment(ec)) {
+        std::error_code ec2;
+        if (!it->is_regular_file(ec2) || it->path().extension() != _TSTR(".cmake")) {
+            continue;
+        }
+        auto size = it->file_size(ec2);
+        auto time = it->last_write_time(ec2).time_since_epoch().count();
+        items.push_back(it->path().filename().string() + ':' + std::to_string(size) + ':' +
+                        std::to_string(time));
+    }
+    std::sort(items.begin() + 1, items.end());
+    return hash_strings(items);
+}
+
+static std::string crawl_settings_stamp() {
+    // everything that changes the dump of an unchanged package
+    std::vector<std::string> items = {
+        TOOL_VERSION,
+        stdc::to_string(g_ctx.cmakePath),
+        g_ctx.cmakeVersion,
+        g_ctx.genex ? "genex" : "ninja",
+        g_ctx.resolveLinks ? "resolve-links" : "",
+    };
+    items.insert(items.end(), g_ctx.extraArgs.begin(), g_ctx.extraArgs.end());
+    return hash_strings(items);
+}
+
+// Snapshot layout:
+//      cmakedump-snapshot 2
+//      <settings>
+//      <count>
+//      <name>\t<stamp>\t<offset>\t<size>\t<config>      (count lines)
+//      <data>
+// The offsets are relative to the start of the data, each package occupies a JSON document
+// in the same layout as the output of a single dump. The whole snapshot is discarded if the
+// settings stamp differs from the one of the current crawl.
+static constexpr const char SNAPSHOT_MAGIC[] = "cmakedump-snapshot 2";
+
+struct SnapshotEntry {
+    std::string stamp;
+    std::string data;
+};
+
+static std::map<std::string, SnapshotEntry> read_snapshot(const fs::path &path,
+                                                          const std::string &settings) {
+    std::map<std::string, SnapshotEntry> result;
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return result;
+    }
+
+    struct IndexItem {
+        std::string name;
+        std::string stamp;
+        size_t offset;
+        size_t size;
+    };
+    std::vector<IndexItem> index;
+
+    std::string line;
+    if (!std::getline(file, line) || line != SNAPSHOT_MAGIC || !std::getline(file, line)) {
+        throw std::runtime_error("bad header");
+    }
+    if (line != settings) {
+        tool::info("Settings changed since the last crawl, dump all packages");
+        return result;
+    }
+    if (!std::getline(file, line)) {
+        throw std::runtime_error("bad header");
+    }
+    size_t count = std::stoul(line);
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::getline(file, line)) {
+            throw std::runtime_error("truncated index");
+        }
+        std::vector<std::string> fields;
+        for (size_t start = 0;;) {
+            auto tab_idx = line.find('\t', start);
+            fields.push_back(line.substr(start, tab_idx - start));
+            if (tab_idx == std::string::npos) {
+                break;
+            }
+            start = tab_idx + 1;
+        }
+        if (fields.size() != 5) {
+            throw std::runtime_error(stdc::formatN("bad index line: %1", line));
+        }
+        index.push_back({fields[0], fields[1], std::stoul(fields[2]), std::stoul(fields[3])});
+    }
+
+    auto dataStart = file.tellg();
+    for (const auto &item : index) {
+        std::string data(item.size, '\0');
+        file.seekg(dataStart + std::streamoff(item.offset));
+        if (!file.read(data.data(), std::streamsize(data.size()))) {
+            throw std::runtime_error(stdc::formatN("truncated data of %1", item.name));
+        }
+        result[item.name] = {item.stamp, std::move(data)};
+    }
+    return result;
+}
+
+static std::string serialize_snapshot(const std::string &settings,
+                                      const std::vector<CrawlPackage> &packages,
+                                      const std::vector<std::string> &data) {
+    std::ostringstream index;
+    std::string body;
+    size_t count = 0;
+    for (size_t i = 0; i < packages.size(); ++i) {
+        // failed packages are left out and retried by the next crawl
+        if (data[i].empty()) {
+            continue;
+        }
+        const auto &package = packages[i];
+        index << package.name << '\t' << package.stamp << '\t' << body.size() << '\t'
+              << data[i].size() << '\t' << stdc::to_string(package.config) << '\n';
+        body += data[i];
+        count++;
+    }
+
+    std::ostringstream os;
+    os << SNAPSHOT_MAGIC << '\n' << settings << '\n' << count << '\n' << index.str() << body;
+    return os.str();
+}
+
+static void write_crawl_script(const fs::path &path, const CrawlPackage &package) {
+    std::string dir = stdc::to_string(package.config.parent_path());
+    std::replace(dir.begin(), dir.end(), '\\', '/');
+
+    std::ofstream scriptFile(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!scriptFile.is_open()) {
+        throw std::runtime_error(stdc::formatN("failed to open file: %1", path));
+    }
+    scriptFile << "find_package(" << package.name << " CONFIG REQUIRED PATHS \"" << dir
+               << "\" NO_DEFAULT_PATH)\n";
+}
+
+static int crawl_handler(const SCL::ParseResult &result) {
+    parse_common_options(result);
+
+    std::vector<fs::path> prefixes;
+    for (const auto &value : result.values("prefix")) {
+        prefixes.push_back(fs::absolute(stdc::path::from_utf8(value.toString())));
+    }
+    if (g_ctx.output.empty()) {
+        throw std::runtime_error("crawl requires a snapshot file specified by -o");
+    }
+
+    // check tools
+    check_cmake();
+    if (!g_ctx.genex) {
+        check_ninja();
+    }
+
+    auto packages = crawl_packages(prefixes);
+
+    // dependencies are searched in the crawled prefixes as well
+    {
+        std::string prefixPath;
+        for (const auto &prefix : prefixes) {
+            if (!prefixPath.empty()) {
+                prefixPath += ';';
+            }
+            prefixPath += stdc::to_string(prefix);
+        }
+        g_ctx.extraArgs.insert(g_ctx.extraArgs.begin(), "-DCMAKE_PREFIX_PATH:STRING=" + prefixPath);
+    }
+
+    auto settings = crawl_settings_stamp();
+    std::map<std::string, SnapshotEntry> previous;
+    try {
+        previous = read_snapshot(g_ctx.output, settings);
+    } catch (const std::exception &e) {
+        tool::warning("ignore broken snapshot %1: %2", g_ctx.output, exception_message(e));
+    }
+
+    // reuse the dumps whose config files are unchanged
+    std::vector<std::string> data(packages.size());
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < packages.size(); ++i) {
+        auto &package = packages[i];
+        package.stamp = crawl_package_stamp(package.config);
+        auto it = previous.find(package.name);
+        if (it != previous.end() && it->second.stamp == package.stamp) {
+            data[i] = std::move(it->second.data);
+        } else {
+            pending.push_back(i);
+        }
+    }
+    if (g_ctx.verbose) {
+        tool::debug("Crawl %1 packages, %2 to dump:", packages.size(), pending.size());
+        for (auto i : pending) {
+            tool::info("  %1: %2", packages[i].name, packages[i].config);
+        }
+    }
+
+    fs::path scriptsDir = g_ctx.dir / _TSTR("scripts");
+    fs::create_directories(scriptsDir);
+
+    // each worker dumps a whole package, the targets are not sharded any further
+    std::atomic<size_t> failed(0);
+    tool::parallel_for(pending.size(), g_ctx.jobs, [&](size_t i) {
+        const auto &package = packages[pending[i]];
+        fs::path name = stdc::path::from_utf8(package.name);
+        try {
+            fs::path script = scriptsDir / name;
+            script += _TSTR(".cmake");
+            write_crawl_script(script, package);
+            auto targets = dump_package(g_ctx.dir / _TSTR("packages") / name, script, 1);
+            data[pending[i]] = serialize_targets(targets);
+        } catch (const std::exception &e) {
+            tool::warning("failed to dump package %1: %2", package.name, exception_message(e));
+            failed++;
+        }
+    });
+
+    write_file_atomically(g_ctx.output, serialize_snapshot(settings, packages, data));
+
+    tool::info("%1 packages: %2 dumped, %3 reused, %4 failed", packages.size(),
+               pending.size() - failed, packages.size() - pending.size(), failed.load());
+
+    // the partial snapshot is kept, but the crawl is incomplete
+    return failed > 0 ? -1 : 0;
+}
+
+#include <stdcorelib/support/popen.h>
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    // try {
+    //     stdc::Popen proc;
+    //     proc.args({
+    //              "git",
+    //             "clone",
+    //             "--recursive",
+    //             "https://github.com/stdware/qwindowkit.git",
+    //         })
+    //         .stdout_(stdout)
+    //         .stderr_(stdc::Popen::STDOUT);
+    //     proc.done();
+    //     int code = proc.wait();
+    //     tool::success("Process exit with code %1", code);
     // } catch (const std::exception &e) {
     //     std::string msg = exception_message(e);
     //     tool::critical("Error: %1", msg);
@@ -699,20 +2355,47 @@ int main(int argc, char *argv[]) {
     // stdc::cprintf("%syellow %s $$ $$ $$$ $$$$ $$$$$ 123 $$ 456\n", "${yellow}", "$${yellow}");
     // return 0;
 
-    SCL::Command rootCommand(stdc::system::application_name(), "Dump CMake package specification.");
-    rootCommand.addOptions({
+    std::vector<SCL::Option> commonOptions = {
         SCL::Option({"--cmake"}, "Path to CMake executable").arg("path"),
         SCL::Option({"--ninja"}, "Path to Ninja executable").arg("path"),
         SCL::Option({"--dir"}, "Path to the temporary directory for CMake configuration")
             .arg("path"),
         SCL::Option({"-o"}, "Output file path").arg("path"),
+        SCL::Option({"--jobs"}, "Number of CMake configurations to run in parallel").arg("N"),
+        SCL::Option({"--genex"}, "Extract usage requirements with file(GENERATE), Ninja is not "
+                                 "required"),
+        SCL::Option({"--resolve-links"},
+                    "Resolve link items to files and read their ELF dynamic sections"),
+        SCL::Option({"--"}, "Extra CMake arguments")
+            .arg(SCL::Argument("args").nargs(SCL::Argument::Remainder)),
+    };
+
+    SCL::Command crawlCommand("crawl",
+                              "Dump all packages found under the prefixes into a snapshot.");
+    for (const auto &option : commonOptions) {
+        crawlCommand.addOption(option);
+    }
+    crawlCommand.addOption(SCL::Option::Verbose);
+    crawlCommand.addArguments({
+        SCL::Argument("prefix", "Prefix to search for package configuration files").multi(),
+    });
+    crawlCommand.addHelpOption(true);
+    crawlCommand.setHandler(crawl_handler);
+
+    SCL::Command rootCommand(stdc::system::application_name(), "Dump CMake package specification.");
+    for (const auto &option : commonOptions) {
+        rootCommand.addOption(option);
+    }
+    rootCommand.addOptions({
+        SCL::Option({"--watch"}, "Re-dump whenever a CMake input of the package changes"),
+        SCL::Option({"--debounce"}, "Quiet period in milliseconds before re-dumping (default: 500)")
+            .arg("ms"),
     });
     rootCommand.addOption(SCL::Option::Verbose);
-    rootCommand.addOption(SCL::Option({"--"}, "Extra CMake arguments")
-                              .arg(SCL::Argument("args").nargs(SCL::Argument::Remainder)));
     rootCommand.addArguments({
         SCL::Argument("script", "CMake script which calls \"find_package()\""),
     });
+    rootCommand.addCommand(crawlCommand);
     rootCommand.addVersionOption(TOOL_VERSION);
     rootCommand.addHelpOption(true);
     rootCommand.setHandler(cmd_handler);
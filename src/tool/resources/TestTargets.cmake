@@ -107,5 +107,25 @@ foreach(_target IN LISTS _targets)
     list(APPEND _exe_targets_paths ${_target} ${_loc})
 endforeach()
 
+# Write direct dependencies of all imported targets
+if(XMAKE_LIST_TARGETS)
+    set(_deps_content)
+
+    foreach(_target IN LISTS _targets)
+        string(APPEND _deps_content "${_target}\n")
+        get_target_property(_deps ${_target} INTERFACE_LINK_LIBRARIES)
+
+        if(NOT _deps)
+            continue()
+        endif()
+
+        foreach(_dep IN LISTS _deps)
+            string(APPEND _deps_content "\t${_dep}\n")
+        endforeach()
+    endforeach()
+
+    file(WRITE "${CMAKE_BINARY_DIR}/target_deps.txt" "${_deps_content}")
+endif()
+
 set(XMAKE_LIBRARY_TARGETS "${_lib_targets}" PARENT_SCOPE)
 set(XMAKE_EXECUTABLE_TARGETS_PATHS "${_exe_targets_paths}" PARENT_SCOPE)
\ No newline at end of file